@@ -17,8 +17,11 @@
 
 #define ERR(msg, args...) fprintf(stderr, "ERROR: "msg"\n", ## args)
  
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
 #include <Ecore.h>
 #include <Ecore_File.h>
 #include <Ecore_Getopt.h>
@@ -30,6 +33,43 @@ Eina_Bool interactive;
 /* global: zero padding */
 Eina_Bool zero_pad;
 
+/* size of the chunks read from and inflated out of a series archive */
+#define STREAM_CHUNK 16384
+
+/* state for streaming the episodes of a full series archive */
+typedef struct _Stream_Ctx {
+	/* filters, as given on the command line */
+	const char *episode_id;
+	const char *date;
+	int episode_num;
+	int season_num;
+	/* files to rename, starting at argv[argi] */
+	char **argv;
+	int argi;
+	int argc;
+	const char *template;
+	/* season and number of the episode the next file is renamed to */
+	int next_season;
+	int next_number;
+	/* series of the episodes, points to local_series if it's read from the archive */
+	Series *series;
+	Series local_series;
+	/* parser state: unparsed XML and the record currently being parsed */
+	Eina_Strbuf *pending;
+	Episode episode;
+	char tag[32];
+	Eina_Bool in_series;
+	Eina_Bool in_episode;
+	/* CRC-32 of the XML fed to the parser so far */
+	uLong crc;
+	/* single episode wanted, rename files instead of printing, nothing left to do */
+	Eina_Bool single;
+	Eina_Bool files;
+	Eina_Bool stop;
+	int found;
+	int ret;
+} Stream_Ctx;
+
 const Ecore_Getopt go_options = {
 	BINARY_NAME,
 	"%prog [options] <files>",
@@ -49,6 +89,8 @@ const Ecore_Getopt go_options = {
 		ECORE_GETOPT_STORE_STR('l', "lang", "set language for TVDB (default: en)"),
 		ECORE_GETOPT_STORE_STR('q', "query", "query for a certain property"),
 		ECORE_GETOPT_STORE_STR('d', "date", "specify air date, e.g. 2014-05-25"),
+		ECORE_GETOPT_STORE_STR('a', "archive", "stream episodes from a local series archive (zip, no padding)"),
+		ECORE_GETOPT_STORE_TRUE('z', "stream", "stream episodes from the full series archive (no padding)"),
 		ECORE_GETOPT_STORE_TRUE('i', "interactive", "requires user input during runtime"),
 		ECORE_GETOPT_LICENSE('L', "license"),
 		ECORE_GETOPT_COPYRIGHT('C', "copyright"),
@@ -92,7 +134,7 @@ char *itoa_pad_by_reference(int value, int reference)
 	return s;
 }
 
-Eina_Bool print_hash(const Eina_Hash *hash, const void *key, void *ser_data, void *fser_data)
+Eina_Bool print_hash(const Eina_Hash *hash EINA_UNUSED, const void *key, void *ser_data, void *fser_data EINA_UNUSED)
 {
 	printf("  \'%s\': %s\n", (char *)key, (char *)ser_data);
 	return EINA_TRUE;
@@ -240,7 +282,8 @@ Eina_Bool modify_episode(Episode *e, const char *file, const char *template)
 		free(buf);
 
 		/* Episode name - path delimitters replaced */
-		tmp_strbuf = eina_strbuf_manage_new(e->name);
+		tmp_strbuf = eina_strbuf_new();
+		eina_strbuf_append(tmp_strbuf, e->name);
 		eina_strbuf_replace_all(tmp_strbuf, "/", "-");
 		eina_strbuf_replace_all(strbuf, "#n", eina_strbuf_string_get(tmp_strbuf));
 		eina_strbuf_free(tmp_strbuf);
@@ -257,7 +300,8 @@ Eina_Bool modify_episode(Episode *e, const char *file, const char *template)
 		free(buf);
 
 		/* Series name - path delimitters replaced */
-		tmp_strbuf = eina_strbuf_manage_new(e->series->name);
+		tmp_strbuf = eina_strbuf_new();
+		eina_strbuf_append(tmp_strbuf, e->series->name);
 		eina_strbuf_replace_all(tmp_strbuf, "/", "-");
 		eina_strbuf_replace_all(strbuf, "#N", eina_strbuf_string_get(tmp_strbuf));
 		eina_strbuf_free(tmp_strbuf);
@@ -344,6 +388,418 @@ void select_series(Eina_List *list, void *series)
 	*s = etvdb_series_from_list_get(list, j - 1);
 }
 
+/* free the fields of a streamed episode and reset it for the next record */
+void stream_episode_clear(Episode *e)
+{
+	free(e->id);
+	free(e->name);
+	free(e->imdb_id);
+	free(e->overview);
+	free(e->firstaired);
+	memset(e, 0, sizeof(Episode));
+}
+
+/* filter a freshly parsed episode and print or rename it right away */
+void stream_episode_handle(Stream_Ctx *ctx, Episode *e)
+{
+	if (ctx->episode_id) {
+		if (!e->id || strcmp(e->id, ctx->episode_id))
+			return;
+	} else if (ctx->date) {
+		if (!e->firstaired || strcmp(e->firstaired, ctx->date))
+			return;
+	} else if (ctx->season_num > -1) {
+		if (e->season != ctx->season_num)
+			return;
+		if (ctx->episode_num && e->number != ctx->episode_num)
+			return;
+	/* like the full series listing, specials are only handled on request */
+	} else if (e->season == 0)
+		return;
+
+	/* files are matched to episodes by season and number, like without streaming,
+	 * so renaming by position is only safe if the archive is sorted that way */
+	if (ctx->files && !ctx->single) {
+		if (ctx->season_num == -1 && e->season == ctx->next_season + 1
+				&& e->number == 1 && ctx->next_number > 1) {
+			ctx->next_season++;
+			ctx->next_number = 1;
+		}
+
+		if (e->season != ctx->next_season || e->number != ctx->next_number) {
+			ERR("Series archive isn't sorted: expected Episode %d in Season %d, got Episode %d in Season %d.",
+					ctx->next_number, ctx->next_season, e->number, e->season);
+			ctx->ret = EXIT_FAILURE;
+			ctx->stop = EINA_TRUE;
+			return;
+		}
+		ctx->next_number++;
+	}
+
+	if (!ctx->files) {
+		if (!ctx->found)
+			print_csv_head();
+		print_csv_episode(e);
+	} else if (!modify_episode(e, ctx->argv[ctx->argi++], ctx->template))
+		ctx->ret = EXIT_FAILURE;
+	ctx->found++;
+
+	/* no need to parse the rest of the archive if we have nothing left to do */
+	if (ctx->single || (ctx->files && ctx->argi == ctx->argc))
+		ctx->stop = EINA_TRUE;
+}
+
+/* copy a tag name from the parser, without attributes */
+void stream_tag_copy(char *tag, const char *content, unsigned length)
+{
+	unsigned i;
+
+	for (i = 0; i < length && i < 31; i++) {
+		if (content[i] == ' ' || content[i] == '\t' || content[i] == '\n'
+				|| content[i] == '\r' || content[i] == '/')
+			break;
+		tag[i] = content[i];
+	}
+	tag[i] = 0;
+}
+
+/* SAX callback for the series archive XML */
+Eina_Bool stream_xml_cb(void *data, Eina_Simple_XML_Type type, const char *content,
+		unsigned offset EINA_UNUSED, unsigned length)
+{
+	Stream_Ctx *ctx = data;
+	Episode *e = &ctx->episode;
+	Series *s = ctx->series;
+	char tag[32];
+
+	if (type == EINA_SIMPLE_XML_OPEN) {
+		stream_tag_copy(ctx->tag, content, length);
+		if (!strcmp(ctx->tag, "Series"))
+			ctx->in_series = EINA_TRUE;
+		else if (!strcmp(ctx->tag, "Episode")) {
+			stream_episode_clear(e);
+			ctx->in_episode = EINA_TRUE;
+		}
+	} else if (type == EINA_SIMPLE_XML_CLOSE) {
+		stream_tag_copy(tag, content, length);
+		if (!strcmp(tag, "Series"))
+			ctx->in_series = EINA_FALSE;
+		else if (!strcmp(tag, "Episode")) {
+			ctx->in_episode = EINA_FALSE;
+			e->series = ctx->series;
+			stream_episode_handle(ctx, e);
+			stream_episode_clear(e);
+		}
+		ctx->tag[0] = 0;
+	} else if (type == EINA_SIMPLE_XML_DATA && ctx->tag[0]) {
+		if (ctx->in_episode) {
+			if (!strcmp(ctx->tag, "id") && !e->id)
+				e->id = strndup(content, length);
+			else if (!strcmp(ctx->tag, "EpisodeName") && !e->name)
+				e->name = strndup(content, length);
+			else if (!strcmp(ctx->tag, "IMDB_ID") && !e->imdb_id)
+				e->imdb_id = strndup(content, length);
+			else if (!strcmp(ctx->tag, "Overview") && !e->overview)
+				e->overview = strndup(content, length);
+			else if (!strcmp(ctx->tag, "FirstAired") && !e->firstaired)
+				e->firstaired = strndup(content, length);
+			else if (!strcmp(ctx->tag, "SeasonNumber"))
+				e->season = strtol(content, NULL, 10);
+			else if (!strcmp(ctx->tag, "EpisodeNumber"))
+				e->number = strtol(content, NULL, 10);
+		/* the series record is only used if we didn't look the series up before */
+		} else if (ctx->in_series && s == &ctx->local_series) {
+			if (!strcmp(ctx->tag, "id") && !s->id)
+				s->id = strndup(content, length);
+			else if (!strcmp(ctx->tag, "SeriesName") && !s->name)
+				s->name = strndup(content, length);
+		}
+	}
+
+	return !ctx->stop;
+}
+
+/* feed inflated XML to the parser
+ * every complete episode record is parsed and handled as soon as it is available,
+ * so only the record currently being read is kept in memory */
+Eina_Bool stream_xml_feed(Stream_Ctx *ctx, const char *buf, size_t len)
+{
+	const char *s, *end;
+	size_t n;
+
+	ctx->crc = crc32(ctx->crc, (const Bytef *)buf, len);
+	eina_strbuf_append_length(ctx->pending, buf, len);
+	while ((s = eina_strbuf_string_get(ctx->pending)) && (end = strstr(s, "</Episode>"))) {
+		n = end - s + strlen("</Episode>");
+		eina_simple_xml_parse(s, n, EINA_TRUE, stream_xml_cb, ctx);
+		eina_strbuf_remove(ctx->pending, 0, n);
+		if (ctx->stop)
+			return EINA_FALSE;
+	}
+
+	return EINA_TRUE;
+}
+
+/* read a little endian integer from a zip header */
+unsigned int zip_le_get(const unsigned char *p, int bytes)
+{
+	unsigned int value = 0;
+
+	while (bytes--)
+		value = (value << 8) | p[bytes];
+
+	return value;
+}
+
+/* inflate a deflated zip entry chunk by chunk
+ * the data is fed to the XML parser, or just skipped if ctx is NULL */
+Eina_Bool stream_zip_inflate(FILE *f, Stream_Ctx *ctx)
+{
+	unsigned char in[STREAM_CHUNK], out[STREAM_CHUNK];
+	int zret = Z_OK;
+	z_stream zs;
+	Eina_Bool ret = EINA_TRUE;
+
+	memset(&zs, 0, sizeof(zs));
+	if (inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+		return EINA_FALSE;
+
+	while (zret != Z_STREAM_END) {
+		if (!zs.avail_in) {
+			zs.avail_in = fread(in, 1, sizeof(in), f);
+			zs.next_in = in;
+			if (!zs.avail_in) {
+				ret = EINA_FALSE;
+				break;
+			}
+		}
+
+		zs.next_out = out;
+		zs.avail_out = sizeof(out);
+		zret = inflate(&zs, Z_NO_FLUSH);
+		if (zret != Z_OK && zret != Z_STREAM_END) {
+			ret = EINA_FALSE;
+			break;
+		}
+
+		if (ctx && !stream_xml_feed(ctx, (char *)out, sizeof(out) - zs.avail_out))
+			break;
+	}
+
+	/* hand back what was read beyond the end of the entry */
+	if (ret && zs.avail_in)
+		fseek(f, -(long)zs.avail_in, SEEK_CUR);
+
+	inflateEnd(&zs);
+
+	return ret;
+}
+
+/* stream the episodes of a full series archive
+ * only the XML of the requested language is parsed, all other entries are skipped */
+Eina_Bool stream_archive(const char *archive, const char *lang, Stream_Ctx *ctx)
+{
+	unsigned char hdr[30], buf[STREAM_CHUNK];
+	unsigned int flags, method, crc, csize, nlen, xlen, n;
+	char name[256], xml[64];
+	Eina_Bool target, found = EINA_FALSE, ret = EINA_TRUE;
+	FILE *f;
+
+	f = fopen(archive, "rb");
+	if (!f) {
+		ERR("Could not open archive \'%s\'.", archive);
+		return EINA_FALSE;
+	}
+
+	snprintf(xml, sizeof(xml), "%s.xml", lang);
+	ctx->pending = eina_strbuf_new();
+
+	/* walk the local file headers, the central directory marks the end */
+	while (!found && fread(hdr, 1, sizeof(hdr), f) == sizeof(hdr)) {
+		if (zip_le_get(hdr, 4) != 0x04034b50)
+			break;
+
+		flags = zip_le_get(hdr + 6, 2);
+		method = zip_le_get(hdr + 8, 2);
+		crc = zip_le_get(hdr + 14, 4);
+		csize = zip_le_get(hdr + 18, 4);
+		nlen = zip_le_get(hdr + 26, 2);
+		xlen = zip_le_get(hdr + 28, 2);
+
+		if (nlen >= sizeof(name) || fread(name, 1, nlen, f) != nlen) {
+			ERR("Archive \'%s\' is corrupt.", archive);
+			ret = EINA_FALSE;
+			break;
+		}
+		name[nlen] = 0;
+		fseek(f, xlen, SEEK_CUR);
+		target = !strcmp(name, xml);
+		if (target)
+			ctx->crc = crc32(0L, Z_NULL, 0);
+
+		if (!target && !(flags & 8)) {
+			fseek(f, csize, SEEK_CUR);
+			continue;
+		} else if (method == 8) {
+			if (!stream_zip_inflate(f, target ? ctx : NULL)) {
+				ERR("Archive \'%s\' is corrupt.", archive);
+				ret = EINA_FALSE;
+				break;
+			}
+		} else if (method == 0 && !(flags & 8)) {
+			while (csize > 0 && !ctx->stop) {
+				n = csize < sizeof(buf) ? csize : sizeof(buf);
+				if (fread(buf, 1, n, f) != n) {
+					ERR("Archive \'%s\' is corrupt.", archive);
+					ret = EINA_FALSE;
+					break;
+				}
+				stream_xml_feed(ctx, (char *)buf, n);
+				csize -= n;
+			}
+			if (!ret)
+				break;
+		} else {
+			ERR("Unsupported compression in archive \'%s\'.", archive);
+			ret = EINA_FALSE;
+			break;
+		}
+
+		found = target;
+
+		/* if we stopped early, the entry wasn't read completely and there's nothing to check */
+		if (ctx->stop)
+			break;
+
+		/* entries of unknown size are followed by a data descriptor, with optional signature */
+		if (flags & 8) {
+			if (fread(hdr, 1, 4, f) != 4
+					|| (zip_le_get(hdr, 4) == 0x08074b50 && fread(hdr, 1, 4, f) != 4)) {
+				ERR("Archive '%s' is corrupt.", archive);
+				ret = EINA_FALSE;
+				break;
+			}
+			crc = zip_le_get(hdr, 4);
+			fseek(f, 8, SEEK_CUR);
+		}
+
+		if (target && ctx->crc != crc) {
+			ERR("Archive '%s' is corrupt.", archive);
+			ret = EINA_FALSE;
+		}
+	}
+
+	if (ret && !found) {
+		ERR("Archive \'%s\' contains no \'%s\'.", archive, xml);
+		ret = EINA_FALSE;
+	}
+
+	stream_episode_clear(&ctx->episode);
+	eina_strbuf_free(ctx->pending);
+	ctx->pending = NULL;
+	fclose(f);
+
+	return ret;
+}
+
+/* completion callback for the archive download */
+void stream_download_done(void *data, const char *file EINA_UNUSED, int status)
+{
+	int *download_status = data;
+
+	*download_status = status;
+	ecore_main_loop_quit();
+}
+
+/* download the full series archive from TVDB to dst */
+Eina_Bool stream_archive_download(const char *series_id, const char *lang, const char *dst)
+{
+	char url[512];
+	int status = -1;
+	Eina_Bool ret = EINA_TRUE;
+
+	snprintf(url, sizeof(url), "http://thetvdb.com/api/%s/series/%s/all/%s.zip",
+			TVDB_API_KEY, series_id, lang);
+
+	ecore_file_init();
+	if (!ecore_file_download(url, dst, stream_download_done, NULL, &status, NULL)) {
+		ERR("Could not start download of %s.", url);
+		ret = EINA_FALSE;
+	} else {
+		ecore_main_loop_begin();
+		/* local copies report 0, HTTP reports its status code */
+		if (status != 0 && status != 200) {
+			ERR("Download of %s failed (%d).", url, status);
+			ret = EINA_FALSE;
+		}
+	}
+	ecore_file_shutdown();
+
+	return ret;
+}
+
+/* fetch the archive once (unless a local one is given) and handle its episodes while parsing */
+Eina_Bool stream_episodes(Stream_Ctx *ctx, const char *archive, const char *series_id, const char *lang)
+{
+	char dir[PATH_MAX], path[PATH_MAX + sizeof("/series.zip")];
+	const char *tmpdir;
+	Eina_Bool ret;
+
+	ctx->single = ctx->episode_id || ctx->date || ctx->episode_num;
+	ctx->files = ctx->argi < ctx->argc;
+	if (!ctx->series)
+		ctx->series = &ctx->local_series;
+	ctx->next_season = ctx->season_num > -1 ? ctx->season_num : 1;
+	ctx->next_number = 1;
+
+	/* season sizes are unknown until the whole archive is read, so we can't pad */
+	if (zero_pad && ctx->files)
+		fprintf(stderr, "Note: numbers aren't zero padded when streaming a series archive.\n");
+	zero_pad = EINA_FALSE;
+
+	if (!archive) {
+		/* download into a private directory, so only files we created get removed */
+		tmpdir = getenv("TMPDIR");
+		snprintf(dir, sizeof(dir), "%s/%s-XXXXXX", tmpdir ? tmpdir : "/tmp", BINARY_NAME);
+		if (!mkdtemp(dir)) {
+			ERR("Could not create a temporary directory for the series archive.");
+			return EINA_FALSE;
+		}
+		snprintf(path, sizeof(path), "%s/series.zip", dir);
+
+		ret = stream_archive_download(series_id, lang, path);
+		if (ret)
+			ret = stream_archive(path, lang, ctx);
+
+		if (ecore_file_exists(path))
+			ecore_file_unlink(path);
+		ecore_file_rmdir(dir);
+	} else
+		ret = stream_archive(archive, lang, ctx);
+
+	if (ret && ctx->single && !ctx->found) {
+		ERR("No matching episode found in the series archive.");
+		ret = EINA_FALSE;
+	}
+
+	/* like without streaming, an empty listing still gets its header */
+	if (ret && !ctx->files && !ctx->single && !ctx->found)
+		print_csv_head();
+
+	/* without streaming, a season with fewer episodes than files isn't renamed at all;
+	 * here the count is only known at the end, so at least don't hide the leftovers */
+	if (ret && ctx->files && !ctx->single && ctx->ret == EXIT_SUCCESS && ctx->argi < ctx->argc) {
+		ERR("%d file(s) left without a matching episode, starting with \'%s\'.",
+				ctx->argc - ctx->argi, ctx->argv[ctx->argi]);
+		ret = EINA_FALSE;
+	}
+
+	free(ctx->local_series.id);
+	free(ctx->local_series.name);
+
+	return ret && ctx->ret == EXIT_SUCCESS;
+}
+
 int main(int argc, char **argv)
 {
 	int i, j;
@@ -351,13 +807,15 @@ int main(int argc, char **argv)
 	int episode_num = 0, season_num = -1;
 	int episode_cnt = 0, season_cnt = 0;
 	int ret = EXIT_SUCCESS;
-	char *date = NULL, *episode_id = NULL, *language = NULL, *query = NULL;
+	char *archive = NULL, *date = NULL, *episode_id = NULL, *language = NULL, *query = NULL;
 	char *series_id = NULL, *series_find_name = NULL ,*series_name = NULL, *template = NULL;
 	Eina_Bool go_quit = EINA_FALSE, lang_help = EINA_FALSE, qry_help = EINA_FALSE, temp_help = EINA_FALSE;
+	Eina_Bool stream = EINA_FALSE;
 	Eina_List *series_list = NULL, *season_list = NULL, *l, *sl;
 	Eina_Hash *languages = NULL;
 	Episode *episode = NULL;
 	Series *series = NULL;
+	Stream_Ctx stream_ctx;
 
 	/* interactive mode defaults to OFF */
 	interactive = EINA_FALSE;
@@ -376,6 +834,8 @@ int main(int argc, char **argv)
 		ECORE_GETOPT_VALUE_STR(language),
 		ECORE_GETOPT_VALUE_STR(query),
 		ECORE_GETOPT_VALUE_STR(date),
+		ECORE_GETOPT_VALUE_STR(archive),
+		ECORE_GETOPT_VALUE_BOOL(stream),
 		ECORE_GETOPT_VALUE_BOOL(interactive),
 		ECORE_GETOPT_VALUE_BOOL(go_quit),
 		ECORE_GETOPT_VALUE_BOOL(go_quit),
@@ -393,7 +853,9 @@ int main(int argc, char **argv)
 		exit(EXIT_FAILURE);
 	}
 
-	if (!etvdb_init(NULL)) {
+	/* etvdb can't tell us its built-in key, so if we have one for streaming,
+	 * the library gets the same one */
+	if (!etvdb_init(*TVDB_API_KEY ? TVDB_API_KEY : NULL)) {
 		ERR("etvdb Init failed.");
 		exit(EXIT_FAILURE);
 	}
@@ -405,6 +867,10 @@ int main(int argc, char **argv)
 	/* store if we have non-option arguments */
 	extra_args = argc - go_index;
 
+	/* a local archive is always streamed */
+	if (archive)
+		stream = EINA_TRUE;
+
 	/* template help */
 	if (temp_help) {
 		printf("Templates allow to define how episodes are stored.\n"
@@ -473,7 +939,7 @@ int main(int argc, char **argv)
 	} else if ((episode_id || episode_num) && (extra_args) > 1) {
 		ERR("You are looking for a Episode, but passed more than one file; please use only one file.");
 		exit(EXIT_FAILURE);
-	} else if (!series_id && !series_name && !episode_id && !series_find_name) {
+	} else if (!series_id && !series_name && !episode_id && !series_find_name && !archive) {
 		ERR("You need to provide at least an Episode ID or an identifier for a Series.");
 		exit(EXIT_FAILURE);
 	} else if (episode_id && (episode_num || season_num > -1 || series_id || series_name)) {
@@ -497,6 +963,18 @@ int main(int argc, char **argv)
 	} else if (date && query) {
 		ERR("Queries and lookup by date can't be combined.");
 		exit(EXIT_FAILURE);
+	} else if (stream && (query || series_find_name)) {
+		ERR("Streaming a series archive can't be combined with queries or find.");
+		exit(EXIT_FAILURE);
+	} else if (stream && !archive && episode_id) {
+		ERR("Streaming by Episode ID only works with a local series archive (--archive).");
+		exit(EXIT_FAILURE);
+	} else if (stream && !archive && !series_id && !series_name) {
+		ERR("To stream a series archive, you need to provide a Series ID or name.");
+		exit(EXIT_FAILURE);
+	} else if (stream && !archive && !*TVDB_API_KEY) {
+		ERR("This build has no TVDB API key, only local archives can be streamed.");
+		exit(EXIT_FAILURE);
 	}
 
 	/* find the series - ask user in interactive mode, else just pick the first one */
@@ -540,6 +1018,27 @@ int main(int argc, char **argv)
 		goto END;
 	}
 
+	/* in stream mode, the full series archive is read once and every episode is
+	 * printed or renamed as soon as it is parsed, nothing else is fetched */
+	if (stream) {
+		memset(&stream_ctx, 0, sizeof(stream_ctx));
+		stream_ctx.episode_id = episode_id;
+		stream_ctx.date = date;
+		stream_ctx.episode_num = episode_num;
+		stream_ctx.season_num = season_num;
+		stream_ctx.argv = argv;
+		stream_ctx.argi = go_index;
+		stream_ctx.argc = argc;
+		stream_ctx.template = template;
+		stream_ctx.series = series;
+
+		if (!stream_episodes(&stream_ctx, archive, series ? series->id : series_id,
+					language ? language : "en"))
+			ret = EXIT_FAILURE;
+
+		goto END;
+	}
+
 	/* make sure we have a valid series structure */
 	if (!series && series_id) {
 		series = etvdb_series_by_id_get(series_id);
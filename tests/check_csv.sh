@@ -0,0 +1,10 @@
+#!/bin/sh
+# run etvdb and compare its CSV output with the expected file
+# usage: check_csv.sh <etvdb binary> <expected csv> [etvdb arguments...]
+
+binary=$1
+expected=$2
+shift 2
+
+output=$("$binary" "$@") || exit 1
+printf '%s\n' "$output" | diff -u "$expected" -
@@ -0,0 +1,28 @@
+#!/bin/sh
+# rename placeholder files with etvdb in a temporary directory and compare the resulting file names
+# usage: check_rename.sh <etvdb binary> <expected file list> <pass|fail> <placeholder files> [etvdb arguments...]
+# the placeholder files are one space separated argument, they are passed to etvdb after its arguments
+
+binary=$1
+expected=$2
+result=$3
+files=$4
+shift 4
+
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT
+cd "$dir" || exit 1
+touch $files
+
+if "$binary" "$@" $files; then
+	status=pass
+else
+	status=fail
+fi
+
+if [ "$status" != "$result" ]; then
+	echo "etvdb was expected to $result, but didn't."
+	exit 1
+fi
+
+find . -type f | LC_ALL=C sort | diff -u "$expected" -